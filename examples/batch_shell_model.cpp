@@ -0,0 +1,59 @@
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+#include "shellmodel/batch.hpp"
+#include "shellmodel/model_space.hpp"
+#include "shellmodel/operators.hpp"
+
+// Usage: batch_shell_model [job_list] [n_threads]
+// Without a job list, sweeps every particle number in the toy p3/2 space.
+int main(int argc, char** argv) {
+  using namespace shellmodel;
+
+  ModelSpace space;
+  space.add_orbital({"p3/2,m=-3/2", 0, 1, 3, -3, +1, 0.0});
+  space.add_orbital({"p3/2,m=-1/2", 0, 1, 3, -1, +1, 0.0});
+  space.add_orbital({"p3/2,m=+1/2", 0, 1, 3, +1, +1, 1.2});
+  space.add_orbital({"p3/2,m=+3/2", 0, 1, 3, +3, +1, 1.2});
+
+  TwoBodyOperator interaction;
+  interaction.set(0, 1, 0, 1, -1.0);
+  interaction.set(1, 0, 1, 0, -1.0);
+  interaction.set(2, 3, 2, 3, -0.7);
+  interaction.set(3, 2, 3, 2, -0.7);
+  interaction.set(0, 3, 1, 2, -0.3);
+  interaction.set(1, 2, 0, 3, -0.3);
+
+  std::vector<BatchJob> jobs;
+  if (argc > 1) {
+    std::ifstream input(argv[1]);
+    if (!input) {
+      std::cerr << "Cannot open job list: " << argv[1] << '\n';
+      return 1;
+    }
+    try {
+      jobs = read_job_list(input);
+    } catch (const std::invalid_argument& ex) {
+      std::cerr << ex.what() << '\n';
+      return 1;
+    }
+  } else {
+    std::istringstream sweep("A1 1 4\nA2 2 6\nA3 3 4\nA4 4 1\n");
+    jobs = read_job_list(sweep);
+  }
+  const std::size_t n_threads = argc > 2 ? static_cast<std::size_t>(std::strtoul(argv[2], nullptr, 10)) : 0;
+
+  std::cout << std::fixed << std::setprecision(6);
+  run_batch(space, interaction, jobs, n_threads, [](const BatchResult& result) {
+    std::cout << result.name << "  N=" << result.n_particles << "  dim=" << result.dimension << "  E:";
+    for (const double e : result.energies) {
+      std::cout << ' ' << e;
+    }
+    std::cout << std::endl;
+  });
+  return 0;
+}
@@ -1,5 +1,6 @@
 #include <iomanip>
 #include <iostream>
+#include <utility>
 
 #include "shellmodel/basis.hpp"
 #include "shellmodel/diagonalization.hpp"
@@ -27,8 +28,8 @@ int main() {
   interaction.set(0, 3, 1, 2, -0.3);
   interaction.set(1, 2, 0, 3, -0.3);
 
-  const auto hamiltonian = HamiltonianBuilder::build(space, basis, interaction);
-  const EigenSystem eig = diagonalize_hermitian(hamiltonian);
+  auto hamiltonian = HamiltonianBuilder::build(space, basis, interaction);
+  const EigenSystem eig = diagonalize_hermitian(std::move(hamiltonian));
 
   OneBodyOperator e2_op;
   OneBodyOperator m1_op;
@@ -56,9 +57,10 @@ int main() {
   }
 
   std::cout << "\nToy electromagnetic observables:\n";
-  std::cout << "  B(E2; 1->0) = " << transition_strength(first_excited, ground_state, e2_matrix) << "\n";
-  std::cout << "  B(M1; 1->0) = " << transition_strength(first_excited, ground_state, m1_matrix) << "\n";
-  std::cout << "  Q(ground)   = " << expectation_value(ground_state, e2_matrix) << "\n";
-  std::cout << "  mu(ground)  = " << expectation_value(ground_state, m1_matrix) << "\n";
+  linalg::Vector workspace(basis.dimension(), 0.0);
+  std::cout << "  B(E2; 1->0) = " << transition_strength(first_excited, ground_state, e2_matrix, workspace) << "\n";
+  std::cout << "  B(M1; 1->0) = " << transition_strength(first_excited, ground_state, m1_matrix, workspace) << "\n";
+  std::cout << "  Q(ground)   = " << expectation_value(ground_state, e2_matrix, workspace) << "\n";
+  std::cout << "  mu(ground)  = " << expectation_value(ground_state, m1_matrix, workspace) << "\n";
   return 0;
 }
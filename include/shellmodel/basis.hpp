@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <unordered_map>
 #include <vector>
@@ -18,6 +19,10 @@ class SlaterBasis {
 
   [[nodiscard]] int index_of(std::uint64_t det) const;
 
+  // Dimension of the basis for the given particle count without generating it, or 0
+  // if it does not fit in std::size_t.
+  [[nodiscard]] static std::size_t count_determinants(int n_particles, int n_single_particle_states);
+
  private:
   int n_particles_ = 0;
   int n_states_ = 0;
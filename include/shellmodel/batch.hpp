@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <istream>
+#include <string>
+#include <vector>
+
+#include "shellmodel/linalg.hpp"
+#include "shellmodel/model_space.hpp"
+#include "shellmodel/operators.hpp"
+#include "shellmodel/thread_pool.hpp"
+
+namespace shellmodel {
+
+struct BatchJob {
+  std::string name;
+  int n_particles = 0;
+  std::size_t n_eigen = 1;
+};
+
+struct BatchResult {
+  std::string name;
+  int n_particles = 0;
+  std::size_t dimension = 0;
+  linalg::Vector energies;
+};
+
+// Reads one job per line as "name n_particles [n_eigen]"; n_eigen defaults to 1.
+// Blank lines and lines starting with '#' are skipped. Throws std::invalid_argument
+// for missing, non-numeric, negative or zero fields and for extra fields.
+std::vector<BatchJob> read_job_list(std::istream& input);
+
+// Runs every job against the shared (read-only) model space and interaction as
+// tasks on pool. Each job builds its Hamiltonian with nested parallel work on the
+// same pool. on_result is invoked once per job as soon as it finishes, serialized
+// across workers, so it can stream results out. The returned results are in
+// job-list order and each holds exactly job.n_eigen energies. Before anything is
+// scheduled, throws std::invalid_argument if a job's n_particles exceeds the number
+// of model-space orbitals or its n_eigen exceeds the basis dimension. If any job
+// throws while running, the remaining jobs still run and the first exception is
+// rethrown at the end.
+std::vector<BatchResult> run_batch(ThreadPool& pool,
+                                   const ModelSpace& model_space,
+                                   const TwoBodyOperator& interaction,
+                                   const std::vector<BatchJob>& jobs,
+                                   const std::function<void(const BatchResult&)>& on_result = {});
+
+// Convenience overload on a pool of n_threads workers (0 = hardware concurrency).
+std::vector<BatchResult> run_batch(const ModelSpace& model_space,
+                                   const TwoBodyOperator& interaction,
+                                   const std::vector<BatchJob>& jobs,
+                                   std::size_t n_threads = 0,
+                                   const std::function<void(const BatchResult&)>& on_result = {});
+
+}  // namespace shellmodel
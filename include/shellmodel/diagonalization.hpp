@@ -1,6 +1,9 @@
 #pragma once
 
+#include <vector>
+
 #include "shellmodel/linalg.hpp"
+#include "shellmodel/transport.hpp"
 
 namespace shellmodel {
 
@@ -9,8 +12,77 @@ struct EigenSystem {
   linalg::Matrix eigenvectors;
 };
 
-EigenSystem diagonalize_hermitian(const linalg::Matrix& matrix,
+// Takes the matrix by value and rotates it in place; pass an rvalue to avoid a copy.
+EigenSystem diagonalize_hermitian(linalg::Matrix matrix,
                                   int max_iterations = 100,
                                   double tolerance = 1e-12);
 
+// Lowest n_eigen eigenpairs of a symmetric matrix via Lanczos with full
+// reorthogonalization. Converged Ritz pairs are locked and the search restarts in
+// their orthogonal complement until no further level can enter the lowest n_eigen,
+// so degenerate levels are returned with their full multiplicity. Every returned pair
+// has a residual norm below tolerance; throws std::runtime_error if a run needs more
+// than max_iterations Krylov vectors.
+EigenSystem lanczos_lowest(const linalg::Matrix& matrix,
+                           std::size_t n_eigen,
+                           int max_iterations = 300,
+                           double tolerance = 1e-10);
+
+// Same solver over a matrix split into contiguous row blocks that together cover
+// [0, dim), all held by the calling process.
+EigenSystem lanczos_lowest(const std::vector<linalg::RowBlock>& blocks,
+                           std::size_t n_eigen,
+                           int max_iterations = 300,
+                           double tolerance = 1e-10);
+
+// Distributed solver: must be called by every rank of transport, each passing the
+// row block it owns (blocks contiguous in rank order, covering the matrix). Krylov
+// vectors are stored as per-rank segments; each mat-vec gathers the vector through
+// the transport and every dot product and norm is an all-reduce. All ranks return
+// the same eigensystem with full-length eigenvectors.
+EigenSystem lanczos_lowest(const linalg::RowBlock& local_block,
+                           Transport& transport,
+                           std::size_t n_eigen,
+                           int max_iterations = 300,
+                           double tolerance = 1e-10);
+
+// Mixed-precision Lanczos for bandwidth-bound runs. The Krylov sweep keeps the
+// matrix values, Krylov vectors and short mat-vec partial sums in float, while dot
+// products, norms and the tridiagonal matrix are accumulated in double. The
+// double-precision matrix then refines the Ritz pairs with Lanczos runs started
+// from their sum. Those runs need far fewer steps than a cold start, and each is
+// capped at refinement_iterations steps. Results meet the same tolerance as
+// lanczos_lowest; throws std::runtime_error if a refinement run hits its cap first.
+//
+// These overloads convert the matrix themselves and hold the float copy next to the
+// double one for the duration of the call.
+EigenSystem lanczos_lowest_mixed(const linalg::Matrix& matrix,
+                                 std::size_t n_eigen,
+                                 int max_iterations = 300,
+                                 double tolerance = 1e-10,
+                                 int refinement_iterations = 300);
+
+EigenSystem lanczos_lowest_mixed(const std::vector<linalg::RowBlock>& blocks,
+                                 std::size_t n_eigen,
+                                 int max_iterations = 300,
+                                 double tolerance = 1e-10,
+                                 int refinement_iterations = 300);
+
+// Same solver with a float copy the caller already holds (e.g. from linalg::convert,
+// built once and reused across solves). The sweep reads only the float values; the
+// double matrix is read only by the refinement. The two must have the same layout.
+EigenSystem lanczos_lowest_mixed(const linalg::Matrix& matrix,
+                                 const linalg::FloatMatrix& float_matrix,
+                                 std::size_t n_eigen,
+                                 int max_iterations = 300,
+                                 double tolerance = 1e-10,
+                                 int refinement_iterations = 300);
+
+EigenSystem lanczos_lowest_mixed(const std::vector<linalg::RowBlock>& blocks,
+                                 const std::vector<linalg::BasicRowBlock<float>>& float_blocks,
+                                 std::size_t n_eigen,
+                                 int max_iterations = 300,
+                                 double tolerance = 1e-10,
+                                 int refinement_iterations = 300);
+
 }  // namespace shellmodel
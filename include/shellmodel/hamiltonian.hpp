@@ -1,9 +1,12 @@
 #pragma once
 
+#include <vector>
+
 #include "shellmodel/basis.hpp"
 #include "shellmodel/linalg.hpp"
 #include "shellmodel/model_space.hpp"
 #include "shellmodel/operators.hpp"
+#include "shellmodel/thread_pool.hpp"
 
 namespace shellmodel {
 
@@ -12,6 +15,27 @@ class HamiltonianBuilder {
   static linalg::Matrix build(const ModelSpace& model_space,
                               const SlaterBasis& basis,
                               const TwoBodyOperator& interaction);
+
+  // Same matrix, with rows spread over the pool's workers. Safe to call from inside
+  // a pool task (e.g. a batch job), in which case it nests on the same workers.
+  static linalg::Matrix build(const ModelSpace& model_space,
+                              const SlaterBasis& basis,
+                              const TwoBodyOperator& interaction,
+                              ThreadPool& pool);
+
+  // Rows [row_begin, row_end) of H over all basis columns, i.e. the slice a single
+  // worker owns when the basis index range is split across workers.
+  static linalg::RowBlock build_rows(const ModelSpace& model_space,
+                                     const SlaterBasis& basis,
+                                     const TwoBodyOperator& interaction,
+                                     std::size_t row_begin,
+                                     std::size_t row_end);
+
+  // Split H into n_parts contiguous row blocks (see linalg::partition_rows).
+  static std::vector<linalg::RowBlock> build_partitioned(const ModelSpace& model_space,
+                                                         const SlaterBasis& basis,
+                                                         const TwoBodyOperator& interaction,
+                                                         std::size_t n_parts);
 };
 
 }  // namespace shellmodel
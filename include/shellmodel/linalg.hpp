@@ -9,28 +9,81 @@
 
 namespace shellmodel::linalg {
 
-class Matrix {
+// Dense row-major matrix. Matrix (double) is the working type; FloatMatrix halves
+// the storage and memory traffic where single-precision values are acceptable.
+template <typename T>
+class BasicMatrix {
  public:
-  Matrix() = default;
-  Matrix(std::size_t rows, std::size_t cols, double value = 0.0)
+  using value_type = T;
+
+  BasicMatrix() = default;
+  BasicMatrix(std::size_t rows, std::size_t cols, T value = T{0})
       : rows_(rows), cols_(cols), data_(rows * cols, value) {}
 
-  static Matrix zero(std::size_t rows, std::size_t cols) { return Matrix(rows, cols, 0.0); }
+  static BasicMatrix zero(std::size_t rows, std::size_t cols) { return BasicMatrix(rows, cols, T{0}); }
 
   [[nodiscard]] std::size_t rows() const { return rows_; }
   [[nodiscard]] std::size_t cols() const { return cols_; }
 
-  double& operator()(std::size_t r, std::size_t c) { return data_[r * cols_ + c]; }
-  double operator()(std::size_t r, std::size_t c) const { return data_[r * cols_ + c]; }
+  T& operator()(std::size_t r, std::size_t c) { return data_[r * cols_ + c]; }
+  T operator()(std::size_t r, std::size_t c) const { return data_[r * cols_ + c]; }
 
  private:
   std::size_t rows_ = 0;
   std::size_t cols_ = 0;
-  std::vector<double> data_;
+  std::vector<T> data_;
 };
 
+using Matrix = BasicMatrix<double>;
+using FloatMatrix = BasicMatrix<float>;
+
+// Element-wise conversion between storage precisions.
+template <typename To, typename From>
+BasicMatrix<To> convert(const BasicMatrix<From>& m) {
+  BasicMatrix<To> out(m.rows(), m.cols());
+  for (std::size_t r = 0; r < m.rows(); ++r) {
+    for (std::size_t c = 0; c < m.cols(); ++c) {
+      out(r, c) = static_cast<To>(m(r, c));
+    }
+  }
+  return out;
+}
+
 using Vector = std::vector<double>;
 
+// Contiguous band of matrix rows [row_begin, row_begin + rows.rows()) owned by one worker.
+template <typename T>
+struct BasicRowBlock {
+  std::size_t row_begin = 0;
+  BasicMatrix<T> rows;
+};
+
+using RowBlock = BasicRowBlock<double>;
+
+template <typename To, typename From>
+BasicRowBlock<To> convert(const BasicRowBlock<From>& block) {
+  return BasicRowBlock<To>{block.row_begin, convert<To>(block.rows)};
+}
+
+// Split [0, n) into at most n_parts contiguous, nearly equal ranges (half-open).
+inline std::vector<std::pair<std::size_t, std::size_t>> partition_rows(std::size_t n, std::size_t n_parts) {
+  if (n_parts == 0) {
+    throw std::invalid_argument("partition_rows needs at least one part");
+  }
+  n_parts = std::min(n_parts, std::max<std::size_t>(n, 1));
+  std::vector<std::pair<std::size_t, std::size_t>> ranges;
+  ranges.reserve(n_parts);
+  const std::size_t base = n / n_parts;
+  const std::size_t extra = n % n_parts;
+  std::size_t begin = 0;
+  for (std::size_t p = 0; p < n_parts; ++p) {
+    const std::size_t end = begin + base + (p < extra ? 1 : 0);
+    ranges.emplace_back(begin, end);
+    begin = end;
+  }
+  return ranges;
+}
+
 inline Matrix identity(std::size_t n) {
   Matrix id(n, n, 0.0);
   for (std::size_t i = 0; i < n; ++i) {
@@ -50,16 +103,28 @@ inline double dot(const Vector& a, const Vector& b) {
   return sum;
 }
 
-inline Vector mat_vec(const Matrix& m, const Vector& v) {
+// Writes m * v into out, resizing it only when its size differs, so a buffer reused
+// across calls is allocated once. v and out must be distinct vectors.
+inline void mat_vec_into(const Matrix& m, const Vector& v, Vector& out) {
   if (m.cols() != v.size()) {
     throw std::invalid_argument("mat_vec size mismatch");
   }
-  Vector out(m.rows(), 0.0);
+  if (&v == &out) {
+    throw std::invalid_argument("mat_vec_into input and output must not alias");
+  }
+  out.resize(m.rows());
   for (std::size_t r = 0; r < m.rows(); ++r) {
+    double sum = 0.0;
     for (std::size_t c = 0; c < m.cols(); ++c) {
-      out[r] += m(r, c) * v[c];
+      sum += m(r, c) * v[c];
     }
+    out[r] = sum;
   }
+}
+
+inline Vector mat_vec(const Matrix& m, const Vector& v) {
+  Vector out;
+  mat_vec_into(m, v, out);
   return out;
 }
 
@@ -71,24 +136,46 @@ inline Vector column(const Matrix& m, std::size_t c) {
   return out;
 }
 
+// Sorts eigenvalues ascending and permutes the eigenvector columns to match, in
+// place: each permutation cycle is rotated through a single column buffer instead of
+// copying the whole matrix.
 inline void sort_eigensystem(Vector& values, Matrix& vectors) {
-  std::vector<std::pair<double, std::size_t>> order;
-  order.reserve(values.size());
-  for (std::size_t i = 0; i < values.size(); ++i) {
-    order.emplace_back(values[i], i);
+  const std::size_t n = values.size();
+  std::vector<std::size_t> order(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    order[i] = i;
   }
-  std::sort(order.begin(), order.end(), [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+  std::sort(order.begin(), order.end(), [&](std::size_t lhs, std::size_t rhs) {
+    return values[lhs] < values[rhs] || (values[lhs] == values[rhs] && lhs < rhs);
+  });
 
-  Vector sorted_values(values.size(), 0.0);
-  Matrix sorted_vectors(vectors.rows(), vectors.cols(), 0.0);
-  for (std::size_t i = 0; i < order.size(); ++i) {
-    sorted_values[i] = order[i].first;
+  // Position i receives the old column order[i]; follow each cycle once and mark
+  // finished positions by setting order[i] = i.
+  Vector held(vectors.rows(), 0.0);
+  for (std::size_t start = 0; start < n; ++start) {
+    if (order[start] == start) {
+      continue;
+    }
+    const double held_value = values[start];
+    for (std::size_t r = 0; r < vectors.rows(); ++r) {
+      held[r] = vectors(r, start);
+    }
+    std::size_t dst = start;
+    while (order[dst] != start) {
+      const std::size_t src = order[dst];
+      values[dst] = values[src];
+      for (std::size_t r = 0; r < vectors.rows(); ++r) {
+        vectors(r, dst) = vectors(r, src);
+      }
+      order[dst] = dst;
+      dst = src;
+    }
+    values[dst] = held_value;
     for (std::size_t r = 0; r < vectors.rows(); ++r) {
-      sorted_vectors(r, i) = vectors(r, order[i].second);
+      vectors(r, dst) = held[r];
     }
+    order[dst] = dst;
   }
-  values = std::move(sorted_values);
-  vectors = std::move(sorted_vectors);
 }
 
 }  // namespace shellmodel::linalg
@@ -16,4 +16,15 @@ double transition_strength(const linalg::Vector& initial_state,
 double expectation_value(const linalg::Vector& state,
                          const linalg::Matrix& operator_matrix);
 
+// Workspace overloads: operator_matrix * state is written into the caller-owned
+// workspace, so a sweep over many states/operators reuses one buffer.
+double transition_strength(const linalg::Vector& initial_state,
+                           const linalg::Vector& final_state,
+                           const linalg::Matrix& operator_matrix,
+                           linalg::Vector& workspace);
+
+double expectation_value(const linalg::Vector& state,
+                         const linalg::Matrix& operator_matrix,
+                         linalg::Vector& workspace);
+
 }  // namespace shellmodel
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace shellmodel {
+
+// Work-stealing thread pool. Each worker owns a deque: tasks submitted from a worker
+// go to the back of its own deque and are popped from the back, while idle workers
+// steal from the front of the others. parallel_for may be called from inside a pool
+// task; the waiting caller executes pending tasks meanwhile, so nested parallelism
+// shares the same workers and cannot deadlock. Idle workers and waiting callers
+// block rather than spin.
+class ThreadPool {
+ public:
+  // n_threads = 0 uses the hardware concurrency.
+  explicit ThreadPool(std::size_t n_threads = 0);
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  [[nodiscard]] std::size_t size() const { return workers_.size(); }
+
+  // Runs body(i) for every i in [0, count) and returns once all calls finished. If
+  // any call throws, the rest still run and the first exception is rethrown. The
+  // calling thread runs tasks too, so a call from outside the pool can have size() + 1
+  // threads executing tasks at once.
+  void parallel_for(std::size_t count, const std::function<void(std::size_t)>& body);
+
+ private:
+  struct Queue {
+    std::mutex mutex;
+    std::deque<std::function<void()>> tasks;
+  };
+
+  void push(std::function<void()> task);
+  bool run_one(std::size_t home);
+  void worker_loop(std::size_t index);
+  [[nodiscard]] std::size_t home_queue() const;
+
+  std::vector<std::unique_ptr<Queue>> queues_;
+  std::vector<std::thread> workers_;
+  std::atomic<std::size_t> queued_{0};
+  std::atomic<std::size_t> next_queue_{0};
+  std::mutex sleep_mutex_;
+  std::condition_variable wake_;
+  bool stopping_ = false;
+};
+
+}  // namespace shellmodel
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <sys/types.h>
+
+#include <cstddef>
+#include <functional>
+#include <span>
+#include <vector>
+
+namespace shellmodel {
+
+// Collective communication between the ranks of a distributed solve. Every rank must
+// issue the same sequence of calls; each call returns once all ranks contributed.
+class Transport {
+ public:
+  virtual ~Transport() = default;
+
+  [[nodiscard]] virtual int rank() const = 0;
+  [[nodiscard]] virtual int size() const = 0;
+
+  // Element-wise sum over all ranks, in place. Partials are added in rank order, so
+  // every rank receives bitwise-identical results.
+  virtual void all_reduce_sum(std::span<double> values) = 0;
+
+  // Each rank passes its segment of a vector of length full.size() starting at
+  // offset; on return full holds the segments of every rank.
+  virtual void all_gather(std::span<const double> local, std::size_t offset, std::span<double> full) = 0;
+  virtual void all_gather(std::span<const float> local, std::size_t offset, std::span<float> full) = 0;
+
+  double all_reduce_sum(double value) {
+    all_reduce_sum(std::span<double>(&value, 1));
+    return value;
+  }
+};
+
+// Single rank; reductions are no-ops and gathers copy the local segment.
+class LocalTransport final : public Transport {
+ public:
+  [[nodiscard]] int rank() const override { return 0; }
+  [[nodiscard]] int size() const override { return 1; }
+
+  using Transport::all_reduce_sum;
+  void all_reduce_sum(std::span<double>) override {}
+  void all_gather(std::span<const double> local, std::size_t offset, std::span<double> full) override;
+  void all_gather(std::span<const float> local, std::size_t offset, std::span<float> full) override;
+};
+
+// Ranks are processes forked from the caller that communicate through an anonymous
+// shared mapping created before the fork. capacity bounds the length of any reduced
+// or gathered vector (in elements); the matrix dimension suffices for Lanczos.
+class SharedMemoryTransport final : public Transport {
+ public:
+  SharedMemoryTransport(int n_ranks, std::size_t capacity);
+  ~SharedMemoryTransport() override;
+
+  SharedMemoryTransport(const SharedMemoryTransport&) = delete;
+  SharedMemoryTransport& operator=(const SharedMemoryTransport&) = delete;
+
+  [[nodiscard]] int rank() const override { return rank_; }
+  [[nodiscard]] int size() const override { return n_ranks_; }
+
+  using Transport::all_reduce_sum;
+  void all_reduce_sum(std::span<double> values) override;
+  void all_gather(std::span<const double> local, std::size_t offset, std::span<double> full) override;
+  void all_gather(std::span<const float> local, std::size_t offset, std::span<float> full) override;
+
+  // Forks size() - 1 workers and calls body on every rank; the caller is rank 0.
+  // Workers exit when body returns. If body throws on any rank, or a worker dies
+  // (e.g. from a signal), the other ranks are released from their pending collective
+  // with an exception, and run() rethrows the rank-0 exception or throws
+  // std::runtime_error for a failed worker.
+  void run(const std::function<void(Transport&)>& body);
+
+ private:
+  struct Header;
+
+  struct Worker {
+    pid_t pid = 0;
+    int status = 0;
+    bool reaped = false;
+  };
+
+  void barrier();
+  bool reap_workers();
+  template <typename T>
+  void gather_impl(std::span<const T> local, std::size_t offset, std::span<T> full);
+
+  int n_ranks_ = 1;
+  int rank_ = 0;
+  std::size_t capacity_ = 0;
+  std::size_t mapping_bytes_ = 0;
+  void* mapping_ = nullptr;
+  Header* header_ = nullptr;
+  double* reduce_slots_ = nullptr;
+  void* gather_buffer_ = nullptr;
+  std::vector<Worker> workers_;
+};
+
+}  // namespace shellmodel
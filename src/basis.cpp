@@ -1,5 +1,7 @@
 #include "shellmodel/basis.hpp"
 
+#include <algorithm>
+#include <limits>
 #include <stdexcept>
 
 namespace shellmodel {
@@ -20,6 +22,20 @@ void choose_states(int start,
   }
 }
 
+// C(n, k), or 0 if it does not fit in std::size_t (such a basis could not be stored anyway).
+std::size_t binomial(int n, int k) {
+  k = std::min(k, n - k);
+  std::size_t result = 1;
+  for (int i = 0; i < k; ++i) {
+    const auto factor = static_cast<std::size_t>(n - i);
+    if (result > std::numeric_limits<std::size_t>::max() / factor) {
+      return 0;
+    }
+    result = result * factor / static_cast<std::size_t>(i + 1);
+  }
+  return result;
+}
+
 }  // namespace
 
 SlaterBasis::SlaterBasis(int n_particles, int n_single_particle_states)
@@ -34,14 +50,24 @@ SlaterBasis::SlaterBasis(int n_particles, int n_single_particle_states)
 }
 
 void SlaterBasis::generate() {
+  const std::size_t dimension = binomial(n_states_, n_particles_);
   determinants_.clear();
+  determinants_.reserve(dimension);
   choose_states(0, n_particles_, n_states_, 0ULL, determinants_);
   index_map_.clear();
+  index_map_.reserve(determinants_.size());
   for (std::size_t i = 0; i < determinants_.size(); ++i) {
     index_map_[determinants_[i]] = static_cast<int>(i);
   }
 }
 
+std::size_t SlaterBasis::count_determinants(int n_particles, int n_single_particle_states) {
+  if (n_particles < 0 || n_particles > n_single_particle_states) {
+    return 0;
+  }
+  return binomial(n_single_particle_states, n_particles);
+}
+
 int SlaterBasis::index_of(std::uint64_t det) const {
   const auto it = index_map_.find(det);
   if (it == index_map_.end()) {
@@ -0,0 +1,107 @@
+#include "shellmodel/batch.hpp"
+
+#include <charconv>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+
+#include "shellmodel/basis.hpp"
+#include "shellmodel/diagonalization.hpp"
+#include "shellmodel/hamiltonian.hpp"
+
+namespace shellmodel {
+namespace {
+
+// Whole-token unsigned/signed integer parse; from_chars rejects a leading '-' for
+// unsigned types, so "-1" cannot wrap around to a huge level count.
+template <typename Int>
+bool parse_integer(const std::string& token, Int& value) {
+  const char* end = token.data() + token.size();
+  const auto [ptr, ec] = std::from_chars(token.data(), end, value);
+  return ec == std::errc() && ptr == end;
+}
+
+BatchResult run_job(const ModelSpace& model_space,
+                    const TwoBodyOperator& interaction,
+                    const BatchJob& job,
+                    ThreadPool& pool) {
+  const SlaterBasis basis(job.n_particles, static_cast<int>(model_space.size()));
+  const auto hamiltonian = HamiltonianBuilder::build(model_space, basis, interaction, pool);
+  EigenSystem eig = lanczos_lowest(hamiltonian, job.n_eigen);
+  return BatchResult{job.name, job.n_particles, basis.dimension(), std::move(eig.eigenvalues)};
+}
+
+void validate_job(const ModelSpace& model_space, const BatchJob& job) {
+  const int n_orbitals = static_cast<int>(model_space.size());
+  if (job.n_particles < 0 || job.n_particles > n_orbitals) {
+    throw std::invalid_argument("Job " + job.name + " has more particles than the model space has orbitals");
+  }
+  // 0 means the dimension overflows std::size_t, which no level count can exceed.
+  const std::size_t dimension = SlaterBasis::count_determinants(job.n_particles, n_orbitals);
+  if (dimension != 0 && job.n_eigen > dimension) {
+    throw std::invalid_argument("Job " + job.name + " requests more levels than its basis dimension");
+  }
+}
+
+}  // namespace
+
+std::vector<BatchJob> read_job_list(std::istream& input) {
+  std::vector<BatchJob> jobs;
+  std::string line;
+  while (std::getline(input, line)) {
+    const auto first = line.find_first_not_of(" \t\r");
+    if (first == std::string::npos || line[first] == '#') {
+      continue;
+    }
+    std::istringstream fields(line);
+    std::vector<std::string> tokens;
+    for (std::string token; fields >> token;) {
+      tokens.push_back(std::move(token));
+    }
+    BatchJob job;
+    if (tokens.size() < 2 || tokens.size() > 3 || !parse_integer(tokens[1], job.n_particles)) {
+      throw std::invalid_argument("Malformed job line: " + line);
+    }
+    if (job.n_particles < 0) {
+      throw std::invalid_argument("Negative particle count in job line: " + line);
+    }
+    job.name = tokens[0];
+    if (tokens.size() == 3 && (!parse_integer(tokens[2], job.n_eigen) || job.n_eigen == 0)) {
+      throw std::invalid_argument("Invalid level count in job line: " + line);
+    }
+    jobs.push_back(std::move(job));
+  }
+  return jobs;
+}
+
+std::vector<BatchResult> run_batch(ThreadPool& pool,
+                                   const ModelSpace& model_space,
+                                   const TwoBodyOperator& interaction,
+                                   const std::vector<BatchJob>& jobs,
+                                   const std::function<void(const BatchResult&)>& on_result) {
+  for (const auto& job : jobs) {
+    validate_job(model_space, job);
+  }
+  std::vector<BatchResult> results(jobs.size());
+  std::mutex report_mutex;
+  pool.parallel_for(jobs.size(), [&](std::size_t index) {
+    BatchResult result = run_job(model_space, interaction, jobs[index], pool);
+    std::lock_guard<std::mutex> lock(report_mutex);
+    if (on_result) {
+      on_result(result);
+    }
+    results[index] = std::move(result);
+  });
+  return results;
+}
+
+std::vector<BatchResult> run_batch(const ModelSpace& model_space,
+                                   const TwoBodyOperator& interaction,
+                                   const std::vector<BatchJob>& jobs,
+                                   std::size_t n_threads,
+                                   const std::function<void(const BatchResult&)>& on_result) {
+  ThreadPool pool(n_threads);
+  return run_batch(pool, model_space, interaction, jobs, on_result);
+}
+
+}  // namespace shellmodel
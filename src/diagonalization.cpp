@@ -1,16 +1,656 @@
 #include "shellmodel/diagonalization.hpp"
 
+#include <algorithm>
+#include <array>
 #include <cmath>
+#include <limits>
+#include <random>
+#include <span>
 #include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "shellmodel/transport.hpp"
 
 namespace shellmodel {
+namespace {
+
+// Residual level the single-precision Lanczos sweep can reliably reach before the
+// double-precision refinement takes over.
+constexpr double kMixedSweepTolerance = 1e-5;
+
+// Relative margin above the highest wanted single-precision eigenvalue below which
+// the double-precision stage accepts levels.
+constexpr double kMixedCutMargin = 1e-4;
+
+// Lanczos steps between convergence checks. A check solves the tridiagonal problem
+// in O(m^2), which outweighs a mat-vec for small matrices; checking less often
+// costs at most kConvergenceCheckInterval - 1 extra steps per run.
+constexpr std::size_t kConvergenceCheckInterval = 4;
+
+// Non-owning view of a row block, so a caller's full matrix can serve as a single
+// block without being copied.
+template <typename T>
+struct BlockView {
+  std::size_t row_begin = 0;
+  const linalg::BasicMatrix<T>* rows = nullptr;
+};
+
+template <typename T>
+using BlockViews = std::vector<BlockView<T>>;
+
+template <typename T>
+BlockViews<T> views_of(const std::vector<linalg::BasicRowBlock<T>>& blocks) {
+  BlockViews<T> views;
+  views.reserve(blocks.size());
+  for (const auto& block : blocks) {
+    views.push_back({block.row_begin, &block.rows});
+  }
+  return views;
+}
+
+// The rows one rank owns (contiguous views covering [local_begin, local_begin +
+// local_size) of an n x n matrix) together with the transport joining the ranks.
+// Vectors are handled as local segments: a mat-vec gathers the full input vector
+// through the transport, and dot products are local partials followed by an
+// all-reduce. With LocalTransport the single rank owns every row.
+template <typename T>
+class DistributedOperator {
+ public:
+  DistributedOperator(BlockViews<T> blocks, Transport& transport)
+      : blocks_(std::move(blocks)), transport_(transport) {
+    if (blocks_.empty()) {
+      throw std::invalid_argument("Row block list must not be empty");
+    }
+    n_ = blocks_.front().rows->cols();
+    local_begin_ = blocks_.front().row_begin;
+    std::size_t next_row = local_begin_;
+    for (const auto& block : blocks_) {
+      if (block.row_begin != next_row || block.rows->cols() != n_) {
+        throw std::invalid_argument("Row blocks must be contiguous and share a column count");
+      }
+      next_row += block.rows->rows();
+    }
+    local_size_ = next_row - local_begin_;
+
+    // Every rank checks that the ranks' row ranges tile [0, n) in rank order.
+    const auto ranks = static_cast<std::size_t>(transport_.size());
+    linalg::Vector layout(2 * ranks, 0.0);
+    layout[2 * static_cast<std::size_t>(transport_.rank())] = static_cast<double>(local_begin_);
+    layout[2 * static_cast<std::size_t>(transport_.rank()) + 1] = static_cast<double>(local_size_);
+    transport_.all_reduce_sum(layout);
+    double expected_begin = 0.0;
+    for (std::size_t r = 0; r < ranks; ++r) {
+      if (layout[2 * r] != expected_begin) {
+        throw std::invalid_argument("Row blocks of all ranks must be contiguous in rank order");
+      }
+      expected_begin += layout[2 * r + 1];
+    }
+    if (expected_begin != static_cast<double>(n_)) {
+      throw std::invalid_argument("Row blocks must cover a square matrix");
+    }
+    gathered_.assign(n_, T{0});
+  }
+
+  [[nodiscard]] std::size_t dimension() const { return n_; }
+  [[nodiscard]] std::size_t local_begin() const { return local_begin_; }
+  [[nodiscard]] std::size_t local_size() const { return local_size_; }
+
+  // Each row product keeps kLanes independent partial sums, which breaks the serial
+  // add chain so the loop vectorizes without reassociation flags. Partials are kept
+  // in the storage type over strips of kStrip columns and the strips are summed in
+  // double, so a float operator gets twice the vector width of a double one while
+  // its rounding stays at the level of its storage.
+  void apply(const std::vector<T>& local_in, std::vector<T>& local_out) {
+    constexpr std::size_t kLanes = 32 / sizeof(T);
+    constexpr std::size_t kStrip = 256;
+    transport_.all_gather(std::span<const T>(local_in), local_begin_, std::span<T>(gathered_));
+    for (const auto& block : blocks_) {
+      const std::size_t offset = block.row_begin - local_begin_;
+      const auto& rows = *block.rows;
+      for (std::size_t r = 0; r < rows.rows(); ++r) {
+        double sum = 0.0;
+        std::size_t c = 0;
+        while (c + kLanes <= n_) {
+          const std::size_t strip_end = std::min(n_ - (n_ - c) % kLanes, c + kStrip);
+          std::array<T, kLanes> partial{};
+          for (; c < strip_end; c += kLanes) {
+            for (std::size_t l = 0; l < kLanes; ++l) {
+              partial[l] += rows(r, c + l) * gathered_[c + l];
+            }
+          }
+          for (const T value : partial) {
+            sum += static_cast<double>(value);
+          }
+        }
+        for (; c < n_; ++c) {
+          sum += static_cast<double>(rows(r, c)) * static_cast<double>(gathered_[c]);
+        }
+        local_out[offset + r] = static_cast<T>(sum);
+      }
+    }
+  }
+
+  double dot(const std::vector<T>& a, const std::vector<T>& b) {
+    return transport_.all_reduce_sum(local_dot(a, b));
+  }
+
+  // Overlaps of w with basis[0, count), reduced across ranks in one collective.
+  void overlaps(const std::vector<std::vector<T>>& basis,
+                std::size_t count,
+                const std::vector<T>& w,
+                linalg::Vector& out) {
+    out.resize(count);
+    for (std::size_t j = 0; j < count; ++j) {
+      out[j] = local_dot(basis[j], w);
+    }
+    transport_.all_reduce_sum(out);
+  }
+
+  // Every rank draws the same full-length sequence and keeps its own segment, so
+  // the start vectors do not depend on how the rows are split.
+  void fill_random(std::mt19937_64& rng, std::vector<T>& local) {
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    for (std::size_t i = 0; i < n_; ++i) {
+      const double value = dist(rng);
+      if (i >= local_begin_ && i < local_begin_ + local_size_) {
+        local[i - local_begin_] = static_cast<T>(value);
+      }
+    }
+  }
+
+  // Writes the full vector assembled from every rank's segment into column c of out.
+  template <typename U>
+  void gather_column(const std::vector<U>& local, linalg::Matrix& out, std::size_t c) {
+    gathered_double_.assign(n_, 0.0);
+    std::span<const double> segment;
+    if constexpr (std::is_same_v<U, double>) {
+      segment = std::span<const double>(local.data(), local_size_);
+    } else {
+      segment_double_.assign(local.begin(), local.begin() + static_cast<std::ptrdiff_t>(local_size_));
+      segment = std::span<const double>(segment_double_);
+    }
+    transport_.all_gather(segment, local_begin_, std::span<double>(gathered_double_));
+    for (std::size_t r = 0; r < n_; ++r) {
+      out(r, c) = gathered_double_[r];
+    }
+  }
+
+ private:
+  double local_dot(const std::vector<T>& a, const std::vector<T>& b) const {
+    double sum = 0.0;
+    for (std::size_t i = 0; i < local_size_; ++i) {
+      sum += static_cast<double>(a[i]) * static_cast<double>(b[i]);
+    }
+    return sum;
+  }
+
+  BlockViews<T> blocks_;
+  Transport& transport_;
+  std::size_t n_ = 0;
+  std::size_t local_begin_ = 0;
+  std::size_t local_size_ = 0;
+  std::vector<T> gathered_;
+  linalg::Vector gathered_double_;
+  linalg::Vector segment_double_;
+};
+
+// Classical Gram-Schmidt applied twice, which is enough to keep the Krylov basis
+// orthogonal to working precision. Each pass needs a single reduction.
+template <typename T>
+void orthogonalize(DistributedOperator<T>& op,
+                   const std::vector<std::vector<T>>& basis,
+                   std::size_t count,
+                   std::vector<T>& w,
+                   linalg::Vector& coeffs) {
+  for (int pass = 0; pass < 2; ++pass) {
+    op.overlaps(basis, count, w, coeffs);
+    for (std::size_t j = 0; j < count; ++j) {
+      const auto& q = basis[j];
+      for (std::size_t i = 0; i < w.size(); ++i) {
+        w[i] = static_cast<T>(static_cast<double>(w[i]) - coeffs[j] * static_cast<double>(q[i]));
+      }
+    }
+  }
+}
+
+template <typename T>
+void scale(std::vector<T>& v, double factor) {
+  for (auto& x : v) {
+    x = static_cast<T>(static_cast<double>(x) * factor);
+  }
+}
+
+// Implicit QL with Wilkinson shifts on the symmetric tridiagonal matrix with
+// diagonal d and off-diagonal e (e[n-1] is scratch); d is overwritten by the
+// unsorted eigenvalues. rotate(i, s, c) applies each plane rotation of eigenvector
+// columns i and i+1 to whichever rows of the eigenvector matrix the caller tracks.
+template <typename Rotate>
+void tridiagonal_ql(linalg::Vector& d, linalg::Vector& e, Rotate&& rotate) {
+  const std::size_t n = d.size();
+  constexpr double eps = std::numeric_limits<double>::epsilon();
+
+  for (std::size_t l = 0; l < n; ++l) {
+    int iterations = 0;
+    std::size_t m = l;
+    do {
+      for (m = l; m + 1 < n; ++m) {
+        const double dd = std::abs(d[m]) + std::abs(d[m + 1]);
+        if (std::abs(e[m]) <= eps * dd) {
+          break;
+        }
+      }
+      if (m == l) {
+        break;
+      }
+      if (++iterations > 60) {
+        throw std::runtime_error("Tridiagonal QL iteration did not converge");
+      }
+      double g = (d[l + 1] - d[l]) / (2.0 * e[l]);
+      double r = std::hypot(g, 1.0);
+      g = d[m] - d[l] + e[l] / (g + std::copysign(r, g));
+      double s = 1.0;
+      double c = 1.0;
+      double p = 0.0;
+      bool underflow = false;
+      for (std::size_t i = m; i-- > l;) {
+        const double f = s * e[i];
+        const double b = c * e[i];
+        r = std::hypot(f, g);
+        e[i + 1] = r;
+        if (r == 0.0) {
+          d[i + 1] -= p;
+          e[m] = 0.0;
+          underflow = true;
+          break;
+        }
+        s = f / r;
+        c = g / r;
+        g = d[i + 1] - p;
+        r = (d[i] - g) * s + 2.0 * c * b;
+        p = s * r;
+        d[i + 1] = g + p;
+        g = c * r - b;
+        rotate(i, s, c);
+      }
+      if (underflow) {
+        continue;
+      }
+      d[l] -= p;
+      e[l] = g;
+      e[m] = 0.0;
+    } while (true);
+  }
+}
+
+void load_tridiagonal(const linalg::Vector& alpha, const linalg::Vector& beta, linalg::Vector& d, linalg::Vector& e) {
+  d.assign(alpha.begin(), alpha.end());
+  e.assign(alpha.size(), 0.0);
+  for (std::size_t i = 0; i + 1 < alpha.size(); ++i) {
+    e[i] = beta[i];
+  }
+}
+
+// Full eigenpairs of the tridiagonal matrix with diagonal alpha and off-diagonal
+// beta, sorted ascending.
+EigenSystem diagonalize_tridiagonal(const linalg::Vector& alpha, const linalg::Vector& beta) {
+  const std::size_t n = alpha.size();
+  linalg::Vector d;
+  linalg::Vector e;
+  load_tridiagonal(alpha, beta, d, e);
+  linalg::Matrix z = linalg::identity(n);
+  tridiagonal_ql(d, e, [&](std::size_t i, double s, double c) {
+    for (std::size_t k = 0; k < n; ++k) {
+      const double zk = z(k, i + 1);
+      z(k, i + 1) = s * z(k, i) + c * zk;
+      z(k, i) = c * z(k, i) - s * zk;
+    }
+  });
+  linalg::sort_eigensystem(d, z);
+  return EigenSystem{std::move(d), std::move(z)};
+}
+
+// Eigenvalues of the tridiagonal matrix and the last component of each eigenvector,
+// which is all the Lanczos convergence test needs. Tracking one row makes a solve
+// O(m^2) instead of O(m^3); the buffers are reused from one Lanczos step to the next.
+struct TridiagonalBottomRow {
+  linalg::Vector values;
+  linalg::Vector bottom;
+  linalg::Vector off_diagonal;
+  linalg::Vector unsorted_values;
+  linalg::Vector unsorted_bottom;
+  std::vector<std::size_t> order;
+
+  void solve(const linalg::Vector& alpha, const linalg::Vector& beta) {
+    const std::size_t n = alpha.size();
+    load_tridiagonal(alpha, beta, unsorted_values, off_diagonal);
+    unsorted_bottom.assign(n, 0.0);
+    unsorted_bottom[n - 1] = 1.0;
+    tridiagonal_ql(unsorted_values, off_diagonal, [&](std::size_t i, double s, double c) {
+      const double zk = unsorted_bottom[i + 1];
+      unsorted_bottom[i + 1] = s * unsorted_bottom[i] + c * zk;
+      unsorted_bottom[i] = c * unsorted_bottom[i] - s * zk;
+    });
+    // Same order as sort_eigensystem, so index i matches column i of the full solve.
+    order.resize(n);
+    for (std::size_t i = 0; i < n; ++i) {
+      order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [&](std::size_t lhs, std::size_t rhs) {
+      return unsorted_values[lhs] < unsorted_values[rhs] ||
+             (unsorted_values[lhs] == unsorted_values[rhs] && lhs < rhs);
+    });
+    values.resize(n);
+    bottom.resize(n);
+    for (std::size_t i = 0; i < n; ++i) {
+      values[i] = unsorted_values[order[i]];
+      bottom[i] = unsorted_bottom[order[i]];
+    }
+  }
+};
+
+// Lanczos with locking. Krylov vectors are stored as T; alpha, beta, the
+// tridiagonal problem and the returned Ritz vectors are double. The reduced scalars
+// are identical on every rank, so all ranks take the same branches and return the
+// same eigensystem.
+//
+// Each run is confined to the orthogonal complement of the Ritz vectors locked so
+// far; basis holds the locked vectors first, followed by the Krylov vectors of the
+// current run, which lock() replaces by the run's chosen Ritz vectors.
+template <typename T>
+class LockedLanczos {
+ public:
+  explicit LockedLanczos(DistributedOperator<T>& op) : op_(op), rng_(0x5eed), w_(op.local_size(), T{0}) {}
+
+  [[nodiscard]] std::size_t locked() const { return n_locked_; }
+  [[nodiscard]] const linalg::Vector& locked_values() const { return locked_values_; }
+
+  // Every rank draws the same sequence, so the start does not depend on the layout.
+  void start_random() {
+    op_.fill_random(rng_, w_);
+    orthogonalize(op_, basis_, basis_.size(), w_, coeffs_);
+  }
 
-EigenSystem diagonalize_hermitian(const linalg::Matrix& matrix, int max_iterations, double tolerance) {
+  // Starts from the sum of the given local segments projected onto the complement;
+  // falls back to a random start if nothing of them is left.
+  void start_from(const std::vector<linalg::Vector>& vectors) {
+    std::fill(w_.begin(), w_.end(), T{0});
+    for (const auto& v : vectors) {
+      for (std::size_t r = 0; r < w_.size(); ++r) {
+        w_[r] = static_cast<T>(static_cast<double>(w_[r]) + v[r]);
+      }
+    }
+    orthogonalize(op_, basis_, basis_.size(), w_, coeffs_);
+    if (std::sqrt(op_.dot(w_, w_)) < 1e-8) {
+      start_random();
+    }
+  }
+
+  // Extends the Krylov space of the current run until converged(step, beta_m)
+  // accepts it (checked every kConvergenceCheckInterval steps once min_steps are
+  // done), the space spans the whole complement, which makes it exact, or it
+  // reaches krylov_max steps. Returns false in the last case; otherwise ritz holds
+  // the Ritz pairs of the run.
+  template <typename Converged>
+  bool run(std::size_t min_steps,
+           std::size_t krylov_max,
+           double tolerance,
+           Converged&& converged,
+           EigenSystem& ritz) {
+    const std::size_t complement = op_.dimension() - n_locked_;
+    alpha_.clear();
+    beta_.clear();
+    double norm = std::sqrt(op_.dot(w_, w_));
+    while (true) {
+      scale(w_, 1.0 / norm);
+      basis_.push_back(w_);
+
+      op_.apply(basis_.back(), w_);
+      alpha_.push_back(op_.dot(w_, basis_.back()));
+      orthogonalize(op_, basis_, basis_.size(), w_, coeffs_);
+      norm = std::sqrt(op_.dot(w_, w_));
+
+      const std::size_t m = basis_.size() - n_locked_;
+      if (m >= min_steps && ((m - min_steps) % kConvergenceCheckInterval == 0 || m == complement ||
+                             m == krylov_max || norm < tolerance)) {
+        step_.solve(alpha_, beta_);
+        if (m == complement || converged(step_, norm)) {
+          break;
+        }
+        if (m == krylov_max) {
+          basis_.resize(n_locked_);
+          return false;
+        }
+      }
+
+      if (norm < tolerance) {
+        // Invariant subspace found before the run converged: restart from a fresh
+        // direction orthogonal to everything built so far.
+        start_random();
+        norm = std::sqrt(op_.dot(w_, w_));
+        beta_.push_back(0.0);
+      } else {
+        beta_.push_back(norm);
+      }
+    }
+    // Full tridiagonal eigenvectors only once the run has stopped.
+    ritz = diagonalize_tridiagonal(alpha_, beta_);
+    return true;
+  }
+
+  // Replaces the current run's Krylov vectors by its `count` lowest Ritz vectors and
+  // locks them.
+  void lock(const EigenSystem& ritz, std::size_t count) {
+    const std::size_t local_n = op_.local_size();
+    const std::size_t m = basis_.size() - n_locked_;
+    std::vector<std::vector<T>> ritz_vectors(count, std::vector<T>(local_n, T{0}));
+    linalg::Vector x(local_n, 0.0);
+    for (std::size_t i = 0; i < count; ++i) {
+      std::fill(x.begin(), x.end(), 0.0);
+      for (std::size_t j = 0; j < m; ++j) {
+        const double coeff = ritz.eigenvectors(j, i);
+        const auto& q = basis_[n_locked_ + j];
+        for (std::size_t r = 0; r < local_n; ++r) {
+          x[r] += coeff * static_cast<double>(q[r]);
+        }
+      }
+      for (std::size_t r = 0; r < local_n; ++r) {
+        ritz_vectors[i][r] = static_cast<T>(x[r]);
+      }
+      locked_values_.push_back(ritz.eigenvalues[i]);
+    }
+    basis_.resize(n_locked_);
+    for (auto& v : ritz_vectors) {
+      basis_.push_back(std::move(v));
+    }
+    n_locked_ = basis_.size();
+  }
+
+  void discard_run() { basis_.resize(n_locked_); }
+
+  // The n_eigen lowest locked pairs, ascending, with full gathered eigenvectors.
+  EigenSystem lowest(std::size_t n_eigen) {
+    std::vector<std::size_t> order(n_locked_);
+    for (std::size_t i = 0; i < n_locked_; ++i) {
+      order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [&](std::size_t lhs, std::size_t rhs) {
+      return locked_values_[lhs] < locked_values_[rhs] || (locked_values_[lhs] == locked_values_[rhs] && lhs < rhs);
+    });
+    EigenSystem result{linalg::Vector(n_eigen, 0.0), linalg::Matrix::zero(op_.dimension(), n_eigen)};
+    for (std::size_t i = 0; i < n_eigen; ++i) {
+      result.eigenvalues[i] = locked_values_[order[i]];
+      op_.gather_column(basis_[order[i]], result.eigenvectors, i);
+    }
+    return result;
+  }
+
+ private:
+  DistributedOperator<T>& op_;
+  std::mt19937_64 rng_;
+  std::vector<std::vector<T>> basis_;
+  std::size_t n_locked_ = 0;
+  linalg::Vector locked_values_;
+  linalg::Vector alpha_;
+  linalg::Vector beta_;
+  linalg::Vector coeffs_;
+  TridiagonalBottomRow step_;
+  std::vector<T> w_;
+};
+
+// A single-vector Krylov space holds only one copy of a degenerate eigenvalue, so
+// the sweep locks the converged pairs of each run and starts the next one in their
+// complement. Runs repeat until the lowest Ritz value of the remaining complement
+// cannot displace any of the n_eigen lowest locked values, which resolves
+// multiplicities.
+template <typename T>
+EigenSystem lanczos_sweep(DistributedOperator<T>& op,
+                          std::size_t n_eigen,
+                          int max_iterations,
+                          double tolerance) {
+  const std::size_t n = op.dimension();
+  if (n_eigen == 0 || n_eigen > n) {
+    throw std::invalid_argument("n_eigen must be in [1, dimension]");
+  }
+  if (max_iterations < 1) {
+    throw std::invalid_argument("max_iterations must be positive");
+  }
+
+  LockedLanczos<T> lanczos(op);
+  linalg::Vector sorted_values;
+  EigenSystem ritz;
+  while (lanczos.locked() < n) {
+    const std::size_t complement = n - lanczos.locked();
+    const std::size_t wanted = std::min(n_eigen, complement);
+    const std::size_t krylov_max = std::min(complement, static_cast<std::size_t>(max_iterations));
+    lanczos.start_random();
+    const bool converged = lanczos.run(wanted, krylov_max, tolerance, [&](const TridiagonalBottomRow& step, double beta) {
+      for (std::size_t i = 0; i < wanted; ++i) {
+        if (std::abs(beta * step.bottom[i]) >= tolerance) {
+          return false;
+        }
+      }
+      return true;
+    }, ritz);
+    if (!converged) {
+      throw std::runtime_error("Lanczos did not converge within max_iterations");
+    }
+
+    if (lanczos.locked_values().size() >= n_eigen) {
+      sorted_values = lanczos.locked_values();
+      std::nth_element(sorted_values.begin(), sorted_values.begin() + static_cast<std::ptrdiff_t>(n_eigen - 1),
+                       sorted_values.end());
+      if (ritz.eigenvalues[0] >= sorted_values[n_eigen - 1] - tolerance) {
+        lanczos.discard_run();
+        break;
+      }
+    }
+    lanczos.lock(ritz, wanted);
+  }
+  return lanczos.lowest(n_eigen);
+}
+
+// Double-precision stage of the mixed solver. Its runs start from the sum of the
+// single-precision Ritz vectors, which is rich in the wanted eigenvectors and
+// carries only rounding-level components of the rest, so a run converges in far
+// fewer steps than one from a random vector. A run stops once every Ritz value
+// below cut has converged, and those pairs are locked. Since a Krylov space holds
+// one vector per degenerate eigenvalue, the next run starts from the same sum
+// projected onto the complement, which leaves the missing partners. The
+// single-precision sweep has already confirmed that no further eigenvalue lies
+// below cut, so no confirming run from a random vector is needed.
+EigenSystem refine_ritz_pairs(DistributedOperator<double>& op,
+                              const EigenSystem& guess,
+                              std::size_t n_eigen,
+                              int refinement_iterations,
+                              double tolerance,
+                              double cut) {
+  const std::size_t n = op.dimension();
+  std::vector<linalg::Vector> starts(guess.eigenvectors.cols(), linalg::Vector(op.local_size(), 0.0));
+  for (std::size_t i = 0; i < starts.size(); ++i) {
+    for (std::size_t r = 0; r < op.local_size(); ++r) {
+      starts[i][r] = guess.eigenvectors(op.local_begin() + r, i);
+    }
+  }
+
+  LockedLanczos<double> lanczos(op);
+  EigenSystem ritz;
+  while (lanczos.locked() < n_eigen) {
+    const std::size_t complement = n - lanczos.locked();
+    const std::size_t krylov_max = std::min(complement, static_cast<std::size_t>(refinement_iterations));
+    if (krylov_max == 0) {
+      throw std::runtime_error("Mixed-precision refinement did not reach tolerance within refinement_iterations");
+    }
+    lanczos.start_from(starts);
+    // At least the lowest pair, so that every run makes progress even if a wanted
+    // level lies above cut after all.
+    const auto count_to_lock = [&](const linalg::Vector& values) {
+      std::size_t count = 1;
+      while (count < values.size() && values[count] <= cut) {
+        ++count;
+      }
+      return count;
+    };
+    const bool converged = lanczos.run(1, krylov_max, tolerance, [&](const TridiagonalBottomRow& step, double beta) {
+      const std::size_t count = count_to_lock(step.values);
+      for (std::size_t i = 0; i < count; ++i) {
+        if (std::abs(beta * step.bottom[i]) >= tolerance) {
+          return false;
+        }
+      }
+      return true;
+    }, ritz);
+    if (!converged) {
+      throw std::runtime_error("Mixed-precision refinement did not reach tolerance within refinement_iterations");
+    }
+    // A run that exhausted the complement is exact, so all its pairs may be locked.
+    std::size_t count = count_to_lock(ritz.eigenvalues);
+    if (ritz.eigenvalues.size() == complement) {
+      count = std::max(count, std::min(complement, n_eigen - lanczos.locked()));
+    }
+    lanczos.lock(ritz, count);
+  }
+  return lanczos.lowest(n_eigen);
+}
+
+EigenSystem mixed_lanczos(const BlockViews<double>& blocks,
+                          BlockViews<float> float_blocks,
+                          std::size_t n_eigen,
+                          int max_iterations,
+                          double tolerance,
+                          int refinement_iterations) {
+  if (refinement_iterations < 0) {
+    throw std::invalid_argument("refinement_iterations must be non-negative");
+  }
+  if (float_blocks.size() != blocks.size()) {
+    throw std::invalid_argument("Float and double row blocks must have the same layout");
+  }
+  for (std::size_t b = 0; b < blocks.size(); ++b) {
+    if (float_blocks[b].row_begin != blocks[b].row_begin || float_blocks[b].rows->rows() != blocks[b].rows->rows() ||
+        float_blocks[b].rows->cols() != blocks[b].rows->cols()) {
+      throw std::invalid_argument("Float and double row blocks must have the same layout");
+    }
+  }
+  LocalTransport transport;
+  DistributedOperator<double> op(blocks, transport);
+  DistributedOperator<float> float_op(std::move(float_blocks), transport);
+  const EigenSystem guess =
+      lanczos_sweep(float_op, n_eigen, max_iterations, std::max(tolerance, kMixedSweepTolerance));
+  // Single-precision eigenvalues are off by about the sweep tolerance plus the
+  // rounding of the stored matrix; the margin keeps every wanted level below cut.
+  const double top = guess.eigenvalues[n_eigen - 1];
+  const double cut = top + kMixedCutMargin * std::max(1.0, std::abs(top));
+  return refine_ritz_pairs(op, guess, n_eigen, refinement_iterations, tolerance, cut);
+}
+
+}  // namespace
+
+EigenSystem diagonalize_hermitian(linalg::Matrix matrix, int max_iterations, double tolerance) {
   if (matrix.rows() != matrix.cols()) {
     throw std::invalid_argument("Matrix must be square");
   }
   const std::size_t n = matrix.rows();
-  linalg::Matrix a = matrix;
+  linalg::Matrix a = std::move(matrix);
   linalg::Matrix v = linalg::identity(n);
 
   for (int iter = 0; iter < max_iterations; ++iter) {
@@ -70,7 +710,79 @@ EigenSystem diagonalize_hermitian(const linalg::Matrix& matrix, int max_iteratio
     values[i] = a(i, i);
   }
   linalg::sort_eigensystem(values, v);
-  return EigenSystem{values, v};
+  return EigenSystem{std::move(values), std::move(v)};
+}
+
+EigenSystem lanczos_lowest(const linalg::Matrix& matrix, std::size_t n_eigen, int max_iterations, double tolerance) {
+  if (matrix.rows() != matrix.cols()) {
+    throw std::invalid_argument("Matrix must be square");
+  }
+  LocalTransport transport;
+  DistributedOperator<double> op(BlockViews<double>{{0, &matrix}}, transport);
+  return lanczos_sweep(op, n_eigen, max_iterations, tolerance);
+}
+
+EigenSystem lanczos_lowest(const std::vector<linalg::RowBlock>& blocks,
+                           std::size_t n_eigen,
+                           int max_iterations,
+                           double tolerance) {
+  LocalTransport transport;
+  DistributedOperator<double> op(views_of(blocks), transport);
+  return lanczos_sweep(op, n_eigen, max_iterations, tolerance);
+}
+
+EigenSystem lanczos_lowest(const linalg::RowBlock& local_block,
+                           Transport& transport,
+                           std::size_t n_eigen,
+                           int max_iterations,
+                           double tolerance) {
+  DistributedOperator<double> op(BlockViews<double>{{local_block.row_begin, &local_block.rows}}, transport);
+  return lanczos_sweep(op, n_eigen, max_iterations, tolerance);
+}
+
+EigenSystem lanczos_lowest_mixed(const linalg::Matrix& matrix,
+                                 std::size_t n_eigen,
+                                 int max_iterations,
+                                 double tolerance,
+                                 int refinement_iterations) {
+  const linalg::FloatMatrix float_matrix = linalg::convert<float>(matrix);
+  return lanczos_lowest_mixed(matrix, float_matrix, n_eigen, max_iterations, tolerance, refinement_iterations);
+}
+
+EigenSystem lanczos_lowest_mixed(const std::vector<linalg::RowBlock>& blocks,
+                                 std::size_t n_eigen,
+                                 int max_iterations,
+                                 double tolerance,
+                                 int refinement_iterations) {
+  std::vector<linalg::BasicRowBlock<float>> float_blocks;
+  float_blocks.reserve(blocks.size());
+  for (const auto& block : blocks) {
+    float_blocks.push_back(linalg::convert<float>(block));
+  }
+  return lanczos_lowest_mixed(blocks, float_blocks, n_eigen, max_iterations, tolerance, refinement_iterations);
+}
+
+EigenSystem lanczos_lowest_mixed(const linalg::Matrix& matrix,
+                                 const linalg::FloatMatrix& float_matrix,
+                                 std::size_t n_eigen,
+                                 int max_iterations,
+                                 double tolerance,
+                                 int refinement_iterations) {
+  if (matrix.rows() != matrix.cols()) {
+    throw std::invalid_argument("Matrix must be square");
+  }
+  return mixed_lanczos(BlockViews<double>{{0, &matrix}}, BlockViews<float>{{0, &float_matrix}}, n_eigen,
+                       max_iterations, tolerance, refinement_iterations);
+}
+
+EigenSystem lanczos_lowest_mixed(const std::vector<linalg::RowBlock>& blocks,
+                                 const std::vector<linalg::BasicRowBlock<float>>& float_blocks,
+                                 std::size_t n_eigen,
+                                 int max_iterations,
+                                 double tolerance,
+                                 int refinement_iterations) {
+  return mixed_lanczos(views_of(blocks), views_of(float_blocks), n_eigen, max_iterations, tolerance,
+                       refinement_iterations);
 }
 
 }  // namespace shellmodel
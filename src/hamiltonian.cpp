@@ -1,6 +1,8 @@
 #include "shellmodel/hamiltonian.hpp"
 
+#include <algorithm>
 #include <cstdint>
+#include <stdexcept>
 
 namespace shellmodel {
 namespace {
@@ -88,6 +90,14 @@ double two_body_element(std::uint64_t bra,
   return value;
 }
 
+double hamiltonian_element(std::uint64_t bra,
+                           std::uint64_t ket,
+                           const ModelSpace& model_space,
+                           const TwoBodyOperator& interaction,
+                           int n_states) {
+  return one_body_element(bra, ket, model_space) + two_body_element(bra, ket, interaction, n_states);
+}
+
 }  // namespace
 
 linalg::Matrix HamiltonianBuilder::build(const ModelSpace& model_space,
@@ -99,8 +109,7 @@ linalg::Matrix HamiltonianBuilder::build(const ModelSpace& model_space,
     for (std::size_t j = i; j < dim; ++j) {
       const auto bra = basis.determinants()[i];
       const auto ket = basis.determinants()[j];
-      const double element = one_body_element(bra, ket, model_space) +
-                             two_body_element(bra, ket, interaction, basis.n_states());
+      const double element = hamiltonian_element(bra, ket, model_space, interaction, basis.n_states());
       hamiltonian(i, j) = element;
       hamiltonian(j, i) = element;
     }
@@ -108,4 +117,62 @@ linalg::Matrix HamiltonianBuilder::build(const ModelSpace& model_space,
   return hamiltonian;
 }
 
+linalg::Matrix HamiltonianBuilder::build(const ModelSpace& model_space,
+                                         const SlaterBasis& basis,
+                                         const TwoBodyOperator& interaction,
+                                         ThreadPool& pool) {
+  const std::size_t dim = basis.dimension();
+  linalg::Matrix hamiltonian = linalg::Matrix::zero(dim, dim);
+  // Rows are dealt out cyclically because the upper-triangle work shrinks with i.
+  // Task t owns rows i = t (mod n_tasks) and writes only (i, j) and (j, i) for j >= i,
+  // so no two tasks touch the same element.
+  const std::size_t n_tasks = std::min(dim, 4 * pool.size());
+  pool.parallel_for(n_tasks, [&](std::size_t task) {
+    for (std::size_t i = task; i < dim; i += n_tasks) {
+      for (std::size_t j = i; j < dim; ++j) {
+        const auto bra = basis.determinants()[i];
+        const auto ket = basis.determinants()[j];
+        const double element = hamiltonian_element(bra, ket, model_space, interaction, basis.n_states());
+        hamiltonian(i, j) = element;
+        hamiltonian(j, i) = element;
+      }
+    }
+  });
+  return hamiltonian;
+}
+
+linalg::RowBlock HamiltonianBuilder::build_rows(const ModelSpace& model_space,
+                                                const SlaterBasis& basis,
+                                                const TwoBodyOperator& interaction,
+                                                std::size_t row_begin,
+                                                std::size_t row_end) {
+  const std::size_t dim = basis.dimension();
+  if (row_begin > row_end || row_end > dim) {
+    throw std::invalid_argument("Invalid row range for Hamiltonian slice");
+  }
+  linalg::RowBlock block{row_begin, linalg::Matrix::zero(row_end - row_begin, dim)};
+  for (std::size_t i = row_begin; i < row_end; ++i) {
+    for (std::size_t j = 0; j < dim; ++j) {
+      // Evaluate the upper triangle only, matching the symmetrization in build().
+      const auto bra = basis.determinants()[std::min(i, j)];
+      const auto ket = basis.determinants()[std::max(i, j)];
+      block.rows(i - row_begin, j) = hamiltonian_element(bra, ket, model_space, interaction, basis.n_states());
+    }
+  }
+  return block;
+}
+
+std::vector<linalg::RowBlock> HamiltonianBuilder::build_partitioned(const ModelSpace& model_space,
+                                                                    const SlaterBasis& basis,
+                                                                    const TwoBodyOperator& interaction,
+                                                                    std::size_t n_parts) {
+  const auto ranges = linalg::partition_rows(basis.dimension(), n_parts);
+  std::vector<linalg::RowBlock> blocks;
+  blocks.reserve(ranges.size());
+  for (const auto& [begin, end] : ranges) {
+    blocks.push_back(build_rows(model_space, basis, interaction, begin, end));
+  }
+  return blocks;
+}
+
 }  // namespace shellmodel
@@ -71,14 +71,29 @@ linalg::Matrix build_one_body_matrix(const SlaterBasis& basis, const OneBodyOper
 double transition_strength(const linalg::Vector& initial_state,
                            const linalg::Vector& final_state,
                            const linalg::Matrix& operator_matrix) {
-  const linalg::Vector op_initial = linalg::mat_vec(operator_matrix, initial_state);
-  const double amplitude = linalg::dot(final_state, op_initial);
-  return amplitude * amplitude;
+  linalg::Vector workspace;
+  return transition_strength(initial_state, final_state, operator_matrix, workspace);
 }
 
 double expectation_value(const linalg::Vector& state, const linalg::Matrix& operator_matrix) {
-  const linalg::Vector op_state = linalg::mat_vec(operator_matrix, state);
-  return linalg::dot(state, op_state);
+  linalg::Vector workspace;
+  return expectation_value(state, operator_matrix, workspace);
+}
+
+double transition_strength(const linalg::Vector& initial_state,
+                           const linalg::Vector& final_state,
+                           const linalg::Matrix& operator_matrix,
+                           linalg::Vector& workspace) {
+  linalg::mat_vec_into(operator_matrix, initial_state, workspace);
+  const double amplitude = linalg::dot(final_state, workspace);
+  return amplitude * amplitude;
+}
+
+double expectation_value(const linalg::Vector& state,
+                         const linalg::Matrix& operator_matrix,
+                         linalg::Vector& workspace) {
+  linalg::mat_vec_into(operator_matrix, state, workspace);
+  return linalg::dot(state, workspace);
 }
 
 }  // namespace shellmodel
@@ -0,0 +1,152 @@
+#include "shellmodel/thread_pool.hpp"
+
+#include <algorithm>
+#include <exception>
+
+namespace shellmodel {
+namespace {
+
+// Identifies the pool and deque of the current worker thread, if any.
+thread_local const ThreadPool* current_pool = nullptr;
+thread_local std::size_t current_index = 0;
+
+}  // namespace
+
+ThreadPool::ThreadPool(std::size_t n_threads) {
+  if (n_threads == 0) {
+    n_threads = std::max(1U, std::thread::hardware_concurrency());
+  }
+  queues_.reserve(n_threads);
+  for (std::size_t i = 0; i < n_threads; ++i) {
+    queues_.push_back(std::make_unique<Queue>());
+  }
+  workers_.reserve(n_threads);
+  for (std::size_t i = 0; i < n_threads; ++i) {
+    workers_.emplace_back([this, i] { worker_loop(i); });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+    stopping_ = true;
+  }
+  wake_.notify_all();
+  for (auto& worker : workers_) {
+    worker.join();
+  }
+}
+
+std::size_t ThreadPool::home_queue() const {
+  return current_pool == this ? current_index : 0;
+}
+
+void ThreadPool::push(std::function<void()> task) {
+  const std::size_t index =
+      current_pool == this ? current_index : next_queue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+  // Count before publishing, so a worker that finds the task never sees the count
+  // drop below zero.
+  queued_.fetch_add(1, std::memory_order_release);
+  {
+    std::lock_guard<std::mutex> lock(queues_[index]->mutex);
+    queues_[index]->tasks.push_back(std::move(task));
+  }
+  {
+    // Orders the publication against a worker checking the wait predicate.
+    std::lock_guard<std::mutex> lock(sleep_mutex_);
+  }
+  wake_.notify_one();
+}
+
+bool ThreadPool::run_one(std::size_t home) {
+  std::function<void()> task;
+  {
+    Queue& own = *queues_[home];
+    std::lock_guard<std::mutex> lock(own.mutex);
+    if (!own.tasks.empty()) {
+      task = std::move(own.tasks.back());
+      own.tasks.pop_back();
+    }
+  }
+  for (std::size_t offset = 1; !task && offset < queues_.size(); ++offset) {
+    Queue& victim = *queues_[(home + offset) % queues_.size()];
+    std::lock_guard<std::mutex> lock(victim.mutex);
+    if (!victim.tasks.empty()) {
+      task = std::move(victim.tasks.front());
+      victim.tasks.pop_front();
+    }
+  }
+  if (!task) {
+    return false;
+  }
+  queued_.fetch_sub(1, std::memory_order_acq_rel);
+  task();
+  return true;
+}
+
+void ThreadPool::worker_loop(std::size_t index) {
+  current_pool = this;
+  current_index = index;
+  while (true) {
+    if (run_one(index)) {
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(sleep_mutex_);
+    wake_.wait(lock, [this] { return stopping_ || queued_.load(std::memory_order_acquire) > 0; });
+    if (stopping_ && queued_.load(std::memory_order_acquire) == 0) {
+      return;
+    }
+  }
+}
+
+void ThreadPool::parallel_for(std::size_t count, const std::function<void(std::size_t)>& body) {
+  if (count == 0) {
+    return;
+  }
+  struct Group {
+    std::atomic<std::size_t> remaining;
+    std::mutex error_mutex;
+    std::exception_ptr error;
+  };
+  auto group = std::make_shared<Group>();
+  group->remaining.store(count, std::memory_order_relaxed);
+  for (std::size_t i = 0; i < count; ++i) {
+    push([this, group, &body, i] {
+      try {
+        body(i);
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(group->error_mutex);
+        if (!group->error) {
+          group->error = std::current_exception();
+        }
+      }
+      if (group->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        // Same handshake as push: the waiter cannot miss this between its predicate
+        // check and going to sleep.
+        {
+          std::lock_guard<std::mutex> lock(sleep_mutex_);
+        }
+        wake_.notify_all();
+      }
+    });
+  }
+
+  // Help while tasks are queued, which is what lets pool tasks nest parallel_for
+  // calls; once nothing is left to run, sleep until new work arrives or the last
+  // task of this group finishes on another thread.
+  const std::size_t home = home_queue();
+  while (group->remaining.load(std::memory_order_acquire) > 0) {
+    if (run_one(home)) {
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(sleep_mutex_);
+    wake_.wait(lock, [this, &group] {
+      return group->remaining.load(std::memory_order_acquire) == 0 || queued_.load(std::memory_order_acquire) > 0;
+    });
+  }
+  if (group->error) {
+    std::rethrow_exception(group->error);
+  }
+}
+
+}  // namespace shellmodel
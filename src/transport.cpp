@@ -0,0 +1,232 @@
+#include "shellmodel/transport.hpp"
+
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <iostream>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace shellmodel {
+
+namespace {
+
+template <typename T>
+void copy_segment(std::span<const T> local, std::size_t offset, std::span<T> full) {
+  if (offset + local.size() > full.size()) {
+    throw std::invalid_argument("all_gather segment exceeds the gathered vector");
+  }
+  std::copy(local.begin(), local.end(), full.begin() + static_cast<std::ptrdiff_t>(offset));
+}
+
+constexpr std::size_t round_up(std::size_t bytes, std::size_t alignment) {
+  return (bytes + alignment - 1) / alignment * alignment;
+}
+
+}  // namespace
+
+void LocalTransport::all_gather(std::span<const double> local, std::size_t offset, std::span<double> full) {
+  copy_segment(local, offset, full);
+}
+
+void LocalTransport::all_gather(std::span<const float> local, std::size_t offset, std::span<float> full) {
+  copy_segment(local, offset, full);
+}
+
+// Lives at the start of the shared mapping. The atomics must be lock-free to be
+// usable across processes.
+struct SharedMemoryTransport::Header {
+  std::atomic<std::uint32_t> arrived{0};
+  std::atomic<std::uint32_t> generation{0};
+  std::atomic<std::uint32_t> aborted{0};
+};
+
+static_assert(std::atomic<std::uint32_t>::is_always_lock_free, "shared-memory barrier needs lock-free atomics");
+
+SharedMemoryTransport::SharedMemoryTransport(int n_ranks, std::size_t capacity)
+    : n_ranks_(n_ranks) {
+  if (n_ranks < 1) {
+    throw std::invalid_argument("SharedMemoryTransport needs at least one rank");
+  }
+  // Room for a per-rank layout exchange on top of the caller's vectors.
+  capacity_ = std::max(capacity, 2 * static_cast<std::size_t>(n_ranks));
+  const std::size_t header_bytes = round_up(sizeof(Header), 64);
+  const std::size_t slot_bytes = round_up(static_cast<std::size_t>(n_ranks) * capacity_ * sizeof(double), 64);
+  mapping_bytes_ = header_bytes + slot_bytes + capacity_ * sizeof(double);
+  mapping_ = mmap(nullptr, mapping_bytes_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if (mapping_ == MAP_FAILED) {
+    mapping_ = nullptr;
+    throw std::runtime_error("Failed to map shared memory for SharedMemoryTransport");
+  }
+  auto* base = static_cast<unsigned char*>(mapping_);
+  header_ = new (base) Header();
+  reduce_slots_ = reinterpret_cast<double*>(base + header_bytes);
+  gather_buffer_ = base + header_bytes + slot_bytes;
+}
+
+SharedMemoryTransport::~SharedMemoryTransport() {
+  if (mapping_ != nullptr) {
+    header_->~Header();
+    munmap(mapping_, mapping_bytes_);
+  }
+}
+
+// Reaps workers that have exited without blocking; returns whether any worker is
+// gone. Only rank 0 owns the worker list.
+bool SharedMemoryTransport::reap_workers() {
+  bool any_gone = false;
+  for (Worker& worker : workers_) {
+    if (!worker.reaped) {
+      pid_t result = 0;
+      do {
+        result = waitpid(worker.pid, &worker.status, WNOHANG);
+      } while (result < 0 && errno == EINTR);
+      worker.reaped = result == worker.pid;
+    }
+    any_gone = any_gone || worker.reaped;
+  }
+  return any_gone;
+}
+
+// Generation-counting barrier. A rank that fails sets aborted, which turns every
+// pending or later wait into an exception instead of a hang. A worker killed by a
+// signal cannot set the flag itself, so rank 0 polls its workers while waiting: a
+// worker that is gone will never arrive, and rank 0 aborts on its behalf.
+void SharedMemoryTransport::barrier() {
+  Header& header = *header_;
+  if (header.aborted.load(std::memory_order_acquire) != 0) {
+    throw std::runtime_error("Transport aborted by another rank");
+  }
+  const std::uint32_t generation = header.generation.load(std::memory_order_acquire);
+  if (header.arrived.fetch_add(1, std::memory_order_acq_rel) + 1 == static_cast<std::uint32_t>(n_ranks_)) {
+    header.arrived.store(0, std::memory_order_relaxed);
+    header.generation.fetch_add(1, std::memory_order_release);
+    return;
+  }
+  constexpr unsigned poll_interval = 256;
+  for (unsigned spins = 1; header.generation.load(std::memory_order_acquire) == generation; ++spins) {
+    if (header.aborted.load(std::memory_order_acquire) != 0) {
+      throw std::runtime_error("Transport aborted by another rank");
+    }
+    // A worker that completed this barrier may exit right away, so recheck the
+    // generation before treating its exit as a failure.
+    if (rank_ == 0 && spins % poll_interval == 0 && reap_workers() &&
+        header.generation.load(std::memory_order_acquire) == generation) {
+      header.aborted.store(1, std::memory_order_release);
+      throw std::runtime_error("Transport aborted: a worker rank exited");
+    }
+    std::this_thread::yield();
+  }
+}
+
+void SharedMemoryTransport::all_reduce_sum(std::span<double> values) {
+  if (values.size() > capacity_) {
+    throw std::invalid_argument("all_reduce_sum exceeds transport capacity");
+  }
+  double* own_slot = reduce_slots_ + static_cast<std::size_t>(rank_) * capacity_;
+  std::copy(values.begin(), values.end(), own_slot);
+  barrier();
+  for (std::size_t i = 0; i < values.size(); ++i) {
+    double sum = 0.0;
+    for (int r = 0; r < n_ranks_; ++r) {
+      sum += reduce_slots_[static_cast<std::size_t>(r) * capacity_ + i];
+    }
+    values[i] = sum;
+  }
+  // Keep the slots stable until every rank has read them.
+  barrier();
+}
+
+template <typename T>
+void SharedMemoryTransport::gather_impl(std::span<const T> local, std::size_t offset, std::span<T> full) {
+  if (full.size() * sizeof(T) > capacity_ * sizeof(double)) {
+    throw std::invalid_argument("all_gather exceeds transport capacity");
+  }
+  auto* buffer = static_cast<T*>(gather_buffer_);
+  copy_segment(local, offset, std::span<T>(buffer, full.size()));
+  barrier();
+  std::copy(buffer, buffer + full.size(), full.begin());
+  barrier();
+}
+
+void SharedMemoryTransport::all_gather(std::span<const double> local, std::size_t offset, std::span<double> full) {
+  gather_impl(local, offset, full);
+}
+
+void SharedMemoryTransport::all_gather(std::span<const float> local, std::size_t offset, std::span<float> full) {
+  gather_impl(local, offset, full);
+}
+
+void SharedMemoryTransport::run(const std::function<void(Transport&)>& body) {
+  if (rank_ != 0) {
+    throw std::logic_error("SharedMemoryTransport::run must be called from rank 0");
+  }
+  header_->arrived.store(0, std::memory_order_relaxed);
+  header_->aborted.store(0, std::memory_order_release);
+  // Unflushed output would otherwise be duplicated into every worker.
+  std::cout.flush();
+  std::cerr.flush();
+  std::fflush(nullptr);
+
+  workers_.clear();
+  workers_.reserve(static_cast<std::size_t>(n_ranks_ - 1));
+  std::exception_ptr error;
+  for (int r = 1; r < n_ranks_; ++r) {
+    const pid_t pid = fork();
+    if (pid == 0) {
+      rank_ = r;
+      workers_.clear();
+      int status = 0;
+      try {
+        body(*this);
+      } catch (...) {
+        header_->aborted.store(1, std::memory_order_release);
+        status = 1;
+      }
+      std::cout.flush();
+      std::fflush(nullptr);
+      _exit(status);
+    }
+    if (pid < 0) {
+      header_->aborted.store(1, std::memory_order_release);
+      error = std::make_exception_ptr(std::runtime_error("fork failed for SharedMemoryTransport worker"));
+      break;
+    }
+    workers_.push_back(Worker{pid});
+  }
+
+  if (!error) {
+    try {
+      body(*this);
+    } catch (...) {
+      header_->aborted.store(1, std::memory_order_release);
+      error = std::current_exception();
+    }
+  }
+
+  bool worker_failed = false;
+  for (Worker& worker : workers_) {
+    while (!worker.reaped && waitpid(worker.pid, &worker.status, 0) < 0 && errno == EINTR) {
+    }
+    worker.reaped = true;
+    worker_failed = worker_failed || !WIFEXITED(worker.status) || WEXITSTATUS(worker.status) != 0;
+  }
+  workers_.clear();
+  if (error) {
+    std::rethrow_exception(error);
+  }
+  if (worker_failed) {
+    throw std::runtime_error("SharedMemoryTransport worker rank failed");
+  }
+}
+
+}  // namespace shellmodel
@@ -1,14 +1,23 @@
+#include <array>
 #include <cmath>
+#include <csignal>
 #include <iostream>
+#include <sstream>
 #include <stdexcept>
+#include <string>
+#include <tuple>
+#include <utility>
 
 #include "shellmodel/basis.hpp"
+#include "shellmodel/batch.hpp"
 #include "shellmodel/diagonalization.hpp"
 #include "shellmodel/hamiltonian.hpp"
 #include "shellmodel/linalg.hpp"
 #include "shellmodel/model_space.hpp"
 #include "shellmodel/observables.hpp"
 #include "shellmodel/operators.hpp"
+#include "shellmodel/thread_pool.hpp"
+#include "shellmodel/transport.hpp"
 
 namespace {
 
@@ -43,6 +52,341 @@ void test_non_interacting_ground_energy() {
   expect_near(eig.eigenvalues[0], 1.0, 1e-10, "Ground-state energy should be sum of two lowest SP energies");
 }
 
+// Eight orbitals with a non-diagonal interaction: large enough that Lanczos has
+// real work to do, small enough for the dense Jacobi reference. More orbitals give
+// the same structure at dimensions only Lanczos references can check.
+struct TestSystem {
+  shellmodel::ModelSpace space;
+  shellmodel::TwoBodyOperator interaction;
+};
+
+TestSystem make_test_system(int n_orbitals = 8) {
+  TestSystem system;
+  for (int i = 0; i < n_orbitals; ++i) {
+    system.space.add_orbital({"o" + std::to_string(i), 0, 1, 3, 2 * (i % 4) - 3, +1, 0.3 * i});
+  }
+  for (int a = 0; a < n_orbitals; ++a) {
+    for (int b = a + 1; b < n_orbitals; ++b) {
+      for (int c = 0; c < n_orbitals; ++c) {
+        for (int d = c + 1; d < n_orbitals; ++d) {
+          if ((a + b + c + d) % 3 != 0) {
+            continue;
+          }
+          const double v = -0.1 * static_cast<double>((a * b + c * d) % 7 + 1);
+          for (const auto& [i, j, k, l] : {std::array{a, b, c, d}, std::array{c, d, a, b}}) {
+            system.interaction.set(i, j, k, l, v);
+            system.interaction.set(j, i, k, l, -v);
+            system.interaction.set(i, j, l, k, -v);
+            system.interaction.set(j, i, l, k, v);
+          }
+        }
+      }
+    }
+  }
+  return system;
+}
+
+// The p3/2 toy space of examples/toy_shell_model.cpp; its spectra have degenerate
+// levels for every particle number.
+TestSystem make_toy_system() {
+  TestSystem system;
+  system.space.add_orbital({"p3/2,m=-3/2", 0, 1, 3, -3, +1, 0.0});
+  system.space.add_orbital({"p3/2,m=-1/2", 0, 1, 3, -1, +1, 0.0});
+  system.space.add_orbital({"p3/2,m=+1/2", 0, 1, 3, +1, +1, 1.2});
+  system.space.add_orbital({"p3/2,m=+3/2", 0, 1, 3, +3, +1, 1.2});
+  system.interaction.set(0, 1, 0, 1, -1.0);
+  system.interaction.set(1, 0, 1, 0, -1.0);
+  system.interaction.set(2, 3, 2, 3, -0.7);
+  system.interaction.set(3, 2, 3, 2, -0.7);
+  system.interaction.set(0, 3, 1, 2, -0.3);
+  system.interaction.set(1, 2, 0, 3, -0.3);
+  return system;
+}
+
+void test_lanczos_resolves_degenerate_levels() {
+  using namespace shellmodel;
+  const auto toy = make_toy_system();
+  for (int n_particles = 1; n_particles <= 3; ++n_particles) {
+    SlaterBasis basis(n_particles, 4);
+    const auto h = HamiltonianBuilder::build(toy.space, basis, toy.interaction);
+    const auto dense = diagonalize_hermitian(h, 10000);
+    for (std::size_t n_eigen = 1; n_eigen <= basis.dimension(); ++n_eigen) {
+      const auto lanczos = lanczos_lowest(h, n_eigen);
+      for (std::size_t i = 0; i < n_eigen; ++i) {
+        expect_near(lanczos.eigenvalues[i], dense.eigenvalues[i], 1e-9, "Lanczos should keep degenerate copies");
+      }
+    }
+  }
+
+  // Threefold-degenerate ground level hidden by a rotation.
+  const std::size_t n = 6;
+  const double diag[n] = {1.0, 1.0, 1.0, 2.0, 2.0, 3.0};
+  linalg::Matrix q(n, n, 0.0);
+  for (std::size_t r = 0; r < n; ++r) {
+    for (std::size_t c = 0; c < n; ++c) {
+      q(r, c) = std::cos(0.7 * static_cast<double>((r + 1) * (c + 2)));
+    }
+  }
+  const auto basis = diagonalize_hermitian([&] {
+    linalg::Matrix sym(n, n, 0.0);
+    for (std::size_t r = 0; r < n; ++r) {
+      for (std::size_t c = 0; c < n; ++c) {
+        sym(r, c) = q(r, c) + q(c, r);
+      }
+    }
+    return sym;
+  }(), 10000);
+  linalg::Matrix h(n, n, 0.0);
+  for (std::size_t r = 0; r < n; ++r) {
+    for (std::size_t c = 0; c < n; ++c) {
+      for (std::size_t k = 0; k < n; ++k) {
+        h(r, c) += basis.eigenvectors(r, k) * diag[k] * basis.eigenvectors(c, k);
+      }
+    }
+  }
+  const auto lanczos = lanczos_lowest(h, 4);
+  for (std::size_t i = 0; i < 4; ++i) {
+    expect_near(lanczos.eigenvalues[i], diag[i], 1e-9, "Lanczos should find all three degenerate ground states");
+  }
+}
+
+void test_partitioned_lanczos_matches_dense() {
+  using namespace shellmodel;
+  const auto system = make_test_system();
+  SlaterBasis basis(3, 8);
+  const auto h = HamiltonianBuilder::build(system.space, basis, system.interaction);
+  const auto blocks = HamiltonianBuilder::build_partitioned(system.space, basis, system.interaction, 3);
+  expect_true(blocks.size() == 3, "Hamiltonian should split into three row blocks");
+  for (const auto& block : blocks) {
+    for (std::size_t r = 0; r < block.rows.rows(); ++r) {
+      for (std::size_t c = 0; c < h.cols(); ++c) {
+        expect_near(block.rows(r, c), h(block.row_begin + r, c), 1e-14, "Row block should match full Hamiltonian");
+      }
+    }
+  }
+
+  const auto dense = diagonalize_hermitian(h, 200000, 1e-13);
+  const auto lanczos = lanczos_lowest(blocks, 3);
+  for (std::size_t i = 0; i < 3; ++i) {
+    expect_near(lanczos.eigenvalues[i], dense.eigenvalues[i], 1e-8, "Partitioned Lanczos should match dense spectrum");
+    const auto x = linalg::column(lanczos.eigenvectors, i);
+    const auto hx = linalg::mat_vec(h, x);
+    for (std::size_t r = 0; r < x.size(); ++r) {
+      expect_near(hx[r], lanczos.eigenvalues[i] * x[r], 1e-8, "Lanczos Ritz vector should be an eigenvector");
+    }
+  }
+}
+
+void test_lanczos_across_processes() {
+  using namespace shellmodel;
+  const auto toy = make_toy_system();
+  const auto system = make_test_system();
+  for (const auto& [test_system, n_particles, n_orbitals, n_eigen] :
+       {std::tuple{&system, 3, 8, std::size_t{3}}, std::tuple{&toy, 2, 4, std::size_t{4}}}) {
+    SlaterBasis basis(n_particles, n_orbitals);
+    const auto h = HamiltonianBuilder::build(test_system->space, basis, test_system->interaction);
+    const auto reference = diagonalize_hermitian(h, 200000, 1e-13);
+    const auto blocks = HamiltonianBuilder::build_partitioned(test_system->space, basis, test_system->interaction, 3);
+
+    SharedMemoryTransport transport(3, basis.dimension());
+    EigenSystem rank0;
+    // Worker ranks throw on a mismatch, which run() reports as a failed worker.
+    transport.run([&](Transport& ranks) {
+      const auto eig = lanczos_lowest(blocks[static_cast<std::size_t>(ranks.rank())], ranks, n_eigen);
+      for (std::size_t i = 0; i < n_eigen; ++i) {
+        expect_near(eig.eigenvalues[i], reference.eigenvalues[i], 1e-8, "Distributed Lanczos should match dense");
+      }
+      if (ranks.rank() == 0) {
+        rank0 = eig;
+      }
+    });
+    for (std::size_t i = 0; i < n_eigen; ++i) {
+      const auto x = linalg::column(rank0.eigenvectors, i);
+      const auto hx = linalg::mat_vec(h, x);
+      for (std::size_t r = 0; r < x.size(); ++r) {
+        expect_near(hx[r], rank0.eigenvalues[i] * x[r], 1e-8, "Gathered Ritz vector should be an eigenvector");
+      }
+    }
+  }
+
+  SharedMemoryTransport transport(2, 4);
+  bool failure_reported = false;
+  try {
+    transport.run([](Transport& ranks) {
+      if (ranks.rank() == 1) {
+        throw std::runtime_error("worker failure");
+      }
+      ranks.all_reduce_sum(1.0);
+    });
+  } catch (const std::runtime_error&) {
+    failure_reported = true;
+  }
+  expect_true(failure_reported, "A failing worker rank should abort the collective and be reported");
+
+  bool kill_reported = false;
+  try {
+    transport.run([](Transport& ranks) {
+      if (ranks.rank() == 1) {
+        std::raise(SIGKILL);
+      }
+      ranks.all_reduce_sum(1.0);
+    });
+  } catch (const std::runtime_error&) {
+    kill_reported = true;
+  }
+  expect_true(kill_reported, "A worker killed by a signal should abort the collective and be reported");
+}
+
+void test_mixed_precision_lanczos_matches_double() {
+  using namespace shellmodel;
+  const auto system = make_test_system();
+  SlaterBasis basis(3, 8);
+  const auto blocks = HamiltonianBuilder::build_partitioned(system.space, basis, system.interaction, 2);
+  std::vector<linalg::BasicRowBlock<float>> float_blocks;
+  for (const auto& block : blocks) {
+    float_blocks.push_back(linalg::convert<float>(block));
+  }
+  const auto reference = lanczos_lowest(blocks, 4);
+  const auto h = HamiltonianBuilder::build(system.space, basis, system.interaction);
+  // The float copy is built once and reused across solves.
+  for (const std::size_t n_eigen : {std::size_t{4}, std::size_t{2}}) {
+    const auto mixed = lanczos_lowest_mixed(blocks, float_blocks, n_eigen);
+    for (std::size_t i = 0; i < n_eigen; ++i) {
+      expect_near(mixed.eigenvalues[i], reference.eigenvalues[i], 1e-8, "Mixed-precision energies should match double");
+      const auto x = linalg::column(mixed.eigenvectors, i);
+      const auto hx = linalg::mat_vec(h, x);
+      for (std::size_t r = 0; r < x.size(); ++r) {
+        expect_near(hx[r], mixed.eigenvalues[i] * x[r], 1e-8, "Refined Ritz vector should be an eigenvector");
+      }
+    }
+  }
+
+  const auto toy = make_toy_system();
+  SlaterBasis toy_basis(2, 4);
+  auto toy_h = HamiltonianBuilder::build(toy.space, toy_basis, toy.interaction);
+  const auto toy_mixed = lanczos_lowest_mixed(toy_h, 4);
+  const auto toy_dense = diagonalize_hermitian(std::move(toy_h), 10000);
+  for (std::size_t i = 0; i < 4; ++i) {
+    expect_near(toy_mixed.eigenvalues[i], toy_dense.eigenvalues[i], 1e-8, "Mixed precision should keep degenerate levels");
+  }
+
+  // Above the fixture's dimension, with the default iteration budgets and tolerance.
+  const auto larger = make_test_system(9);
+  SlaterBasis larger_basis(4, 9);
+  const auto larger_h = HamiltonianBuilder::build(larger.space, larger_basis, larger.interaction);
+  const auto larger_reference = lanczos_lowest(larger_h, 4);
+  const auto larger_mixed = lanczos_lowest_mixed(larger_h, 4);
+  for (std::size_t i = 0; i < 4; ++i) {
+    expect_near(larger_mixed.eigenvalues[i], larger_reference.eigenvalues[i], 1e-8,
+                "Mixed precision should converge with default arguments above the fixture dimension");
+  }
+
+  bool unconverged_reported = false;
+  try {
+    lanczos_lowest_mixed(h, 4, 300, 1e-14, 0);
+  } catch (const std::runtime_error&) {
+    unconverged_reported = true;
+  }
+  expect_true(unconverged_reported, "Mixed precision should throw when refinement misses the tolerance");
+}
+
+void test_batch_matches_dense() {
+  using namespace shellmodel;
+  std::istringstream job_list("# sweep\nN1 1 2\n\nN2 2 3\nN3 3\nN6 6 2\nN7 7 1\n");
+  const auto jobs = read_job_list(job_list);
+  expect_true(jobs.size() == 5 && jobs[2].n_eigen == 1, "Job list should parse five jobs with default n_eigen");
+  for (const char* bad : {"A1 1 foo\n", "A2 2 -1\n", "A3 3 0\n", "A4 4 2 extra\n", "A5\n", "A6 x 1\n", "A7 -3 2\n"}) {
+    std::istringstream line(bad);
+    bool rejected = false;
+    try {
+      read_job_list(line);
+    } catch (const std::invalid_argument&) {
+      rejected = true;
+    }
+    expect_true(rejected, "Malformed job lines should be rejected");
+  }
+
+  ThreadPool pool(3);
+  const auto system = make_test_system();
+  const auto toy = make_toy_system();
+  std::istringstream toy_list("A1 1 2\nA2 2 4\nA3 3 2\nA4 4 1\n");
+  const auto toy_jobs = read_job_list(toy_list);
+  for (const auto& [test_system, batch, n_orbitals] :
+       {std::tuple{&system, &jobs, 8}, std::tuple{&toy, &toy_jobs, 4}}) {
+    std::size_t reported = 0;
+    const auto results = run_batch(pool, test_system->space, test_system->interaction, *batch,
+                                   [&](const BatchResult&) { ++reported; });
+    expect_true(reported == batch->size(), "Every finished job should be reported once");
+    for (std::size_t i = 0; i < batch->size(); ++i) {
+      const auto& job = (*batch)[i];
+      const SlaterBasis basis(job.n_particles, n_orbitals);
+      auto h = HamiltonianBuilder::build(test_system->space, basis, test_system->interaction);
+      if (test_system == &toy) {
+        const auto pooled = HamiltonianBuilder::build(toy.space, basis, toy.interaction, pool);
+        for (std::size_t r = 0; r < h.rows(); ++r) {
+          for (std::size_t c = 0; c < h.cols(); ++c) {
+            expect_true(pooled(r, c) == h(r, c), "Pooled Hamiltonian build should match serial build");
+          }
+        }
+      }
+      const auto dense = diagonalize_hermitian(std::move(h), 200000, 1e-13);
+      expect_true(results[i].name == job.name, "Batch results should keep job order");
+      expect_true(results[i].energies.size() == job.n_eigen, "Batch job should return requested levels");
+      for (std::size_t k = 0; k < job.n_eigen; ++k) {
+        expect_near(results[i].energies[k], dense.eigenvalues[k], 1e-9, "Batch energies should match dense solver");
+      }
+    }
+  }
+
+  // Jobs that cannot be satisfied are rejected before any job runs.
+  for (const char* unsatisfiable : {"B1 1 2\nB2 5 1\n", "B1 1 2\nB3 4 2\n", "B1 1 2\nB4 3 5\n"}) {
+    std::istringstream list(unsatisfiable);
+    const auto bad_jobs = read_job_list(list);
+    std::size_t reported = 0;
+    bool rejected = false;
+    try {
+      run_batch(pool, toy.space, toy.interaction, bad_jobs, [&](const BatchResult&) { ++reported; });
+    } catch (const std::invalid_argument&) {
+      rejected = true;
+    }
+    expect_true(rejected && reported == 0, "Unsatisfiable jobs should be rejected before scheduling");
+  }
+}
+
+void test_in_place_sort_and_mat_vec_into() {
+  using namespace shellmodel;
+  linalg::Vector values{3.0, -1.0, 2.0, 0.5, -4.0};
+  linalg::Matrix vectors(2, 5, 0.0);
+  for (std::size_t c = 0; c < 5; ++c) {
+    vectors(0, c) = values[c];
+    vectors(1, c) = 10.0 * values[c];
+  }
+  linalg::sort_eigensystem(values, vectors);
+  for (std::size_t c = 0; c < 5; ++c) {
+    expect_true(c == 0 || values[c - 1] <= values[c], "Eigenvalues should be sorted ascending");
+    expect_true(vectors(0, c) == values[c] && vectors(1, c) == 10.0 * values[c],
+                "Eigenvector columns should follow their eigenvalues");
+  }
+
+  linalg::Matrix m(2, 2, 0.0);
+  m(0, 0) = 2.0;
+  m(0, 1) = 1.0;
+  m(1, 1) = 3.0;
+  linalg::Vector out(2, 0.0);
+  const double* storage = out.data();
+  linalg::mat_vec_into(m, {1.0, 1.0}, out);
+  expect_true(out.data() == storage, "mat_vec_into should reuse a correctly sized buffer");
+  expect_near(out[0], 3.0, 1e-15, "mat_vec_into row 0");
+  expect_near(out[1], 3.0, 1e-15, "mat_vec_into row 1");
+  bool aliasing_rejected = false;
+  try {
+    linalg::mat_vec_into(m, out, out);
+  } catch (const std::invalid_argument&) {
+    aliasing_rejected = true;
+  }
+  expect_true(aliasing_rejected, "mat_vec_into should reject aliased input and output");
+}
+
 void test_transition_strength() {
   shellmodel::linalg::Matrix op(2, 2, 0.0);
   op(0, 1) = 1.0;
@@ -60,6 +404,12 @@ int main() {
     test_basis_dimension();
     test_non_interacting_ground_energy();
     test_transition_strength();
+    test_in_place_sort_and_mat_vec_into();
+    test_partitioned_lanczos_matches_dense();
+    test_lanczos_resolves_degenerate_levels();
+    test_lanczos_across_processes();
+    test_mixed_precision_lanczos_matches_double();
+    test_batch_matches_dense();
     std::cout << "All tests passed.\n";
     return 0;
   } catch (const std::exception& ex) {